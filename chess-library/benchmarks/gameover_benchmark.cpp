@@ -0,0 +1,88 @@
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include "../src/include.hpp"
+
+using namespace chess;
+using namespace std::chrono;
+
+// Collects all positions reachable within depth plies, so that both
+// functions below are timed on the exact same set of boards.
+void collect(Board& board, int depth, std::vector<Board>& boards) {
+    boards.push_back(board);
+
+    if (depth == 0) return;
+
+    Movelist moves;
+    movegen::legalmoves(moves, board);
+
+    for (const auto& move : moves) {
+        board.makeMove(move);
+        collect(board, depth - 1, boards);
+        board.unmakeMove(move);
+    }
+}
+
+template <typename F>
+std::pair<uint64_t, int64_t> run(const std::vector<Board>& boards, int iterations, F func) {
+    uint64_t found = 0;
+
+    const auto t1 = high_resolution_clock::now();
+
+    for (int i = 0; i < iterations; i++) {
+        for (const auto& board : boards) {
+            found += func(board);
+        }
+    }
+
+    const auto t2 = high_resolution_clock::now();
+
+    return {found, duration_cast<microseconds>(t2 - t1).count()};
+}
+
+int main() {
+    const std::string fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 1"};
+
+    constexpr int iterations = 10;
+
+    for (const auto& fen : fens) {
+        Board board(fen);
+        std::vector<Board> boards;
+        collect(board, 3, boards);
+
+        const auto [full_found, full_us] = run(boards, iterations, [](const Board& b) {
+            Movelist moves;
+            movegen::legalmoves(moves, b);
+            return !moves.empty();
+        });
+
+        const auto [early_found, early_us] =
+            run(boards, iterations, [](const Board& b) { return movegen::hasLegalMove(b); });
+
+        if (full_found != early_found) {
+            throw std::runtime_error("hasLegalMove() and legalmoves() are inconsistent");
+        }
+
+        std::stringstream ss;
+
+        // clang-format off
+        ss << "positions " << std::left << std::setw(9) << boards.size()
+           << " legalmoves " << std::setw(8) << full_us << "us"
+           << " hasLegalMove " << std::setw(8) << early_us << "us"
+           << " speedup " << std::fixed << std::setprecision(2) << std::setw(6)
+           << static_cast<double>(full_us) / (early_us + 1)
+           << " fen " << fen;
+        // clang-format on
+        std::cout << ss.str() << std::endl;
+    }
+
+    return 0;
+}
@@ -1448,7 +1448,34 @@ class movegen {
                            int pieces = PieceGenType::PAWN | PieceGenType::KNIGHT | PieceGenType::BISHOP |
                                         PieceGenType::ROOK | PieceGenType::QUEEN | PieceGenType::KING);
 
+    /**
+     * @brief Generates all legal moves for a position whose destination square is in targets.
+     * En passant is included if either the en passant square or the captured pawn is in targets,
+     * castling if the rook square is.
+     * @tparam mt
+     * @tparam pieces PieceGenType mask, piece types not in the mask are compiled out.
+     * @param movelist
+     * @param board
+     * @param targets
+     */
+    template <MoveGenType mt = MoveGenType::ALL,
+              int pieces     = PieceGenType::PAWN | PieceGenType::KNIGHT | PieceGenType::BISHOP | PieceGenType::ROOK |
+                           PieceGenType::QUEEN | PieceGenType::KING>
+    void static legalmoves(Movelist &movelist, const Board &board, Bitboard targets);
+
+    /**
+     * @brief Checks if the side to move has at least one legal move.
+     * Returns on the first legal move found instead of generating the full movelist,
+     * trying king moves first, then unpinned pieces and finally pinned pieces.
+     * @param board
+     * @return
+     */
+    [[nodiscard]] static bool hasLegalMove(const Board &board);
+
    private:
+    static constexpr int ALL_PIECES = PieceGenType::PAWN | PieceGenType::KNIGHT | PieceGenType::BISHOP |
+                                      PieceGenType::ROOK | PieceGenType::QUEEN | PieceGenType::KING;
+
     static auto init_squares_between();
     static const std::array<std::array<Bitboard, 64>, 64> SQUARES_BETWEEN_BB;
 
@@ -1469,7 +1496,7 @@ class movegen {
     // Generate pawn moves.
     template <Color::underlying c, MoveGenType mt>
     static void generatePawnMoves(const Board &board, Movelist &moves, Bitboard pin_d, Bitboard pin_hv,
-                                  Bitboard checkmask, Bitboard occ_enemy);
+                                  Bitboard checkmask, Bitboard occ_enemy, Bitboard targets);
 
     [[nodiscard]] static std::array<Move, 2> generateEPMove(const Board &board, Bitboard checkmask, Bitboard pin_d,
                                                             Bitboard pawns_lr, Square ep, Color c);
@@ -1490,8 +1517,16 @@ class movegen {
     template <typename T>
     static void whileBitboardAdd(Movelist &movelist, Bitboard mask, T func);
 
-    template <Color::underlying c, MoveGenType mt>
-    static void legalmoves(Movelist &movelist, const Board &board, int pieces);
+    // pieces is checked at compile time, pieces_mask at runtime. Only types in both are generated.
+    template <Color::underlying c, MoveGenType mt, int pieces>
+    static void legalmoves(Movelist &movelist, const Board &board, int pieces_mask, Bitboard targets);
+
+    template <Color::underlying c>
+    [[nodiscard]] static bool hasPawnMove(const Board &board, Bitboard pin_d, Bitboard pin_hv, Bitboard checkmask,
+                                          Bitboard occ_opp);
+
+    template <Color::underlying c>
+    [[nodiscard]] static bool hasLegalMove(const Board &board);
 
     template <Color::underlying c>
     static bool isEpSquareValid(const Board &board, Square ep);
@@ -2407,10 +2442,7 @@ class Board {
      * @return
      */
     [[nodiscard]] std::pair<GameResultReason, GameResult> getHalfMoveDrawType() const noexcept {
-        Movelist movelist;
-        movegen::legalmoves(movelist, *this);
-
-        if (movelist.empty() && inCheck()) {
+        if (inCheck() && !movegen::hasLegalMove(*this)) {
             return {GameResultReason::CHECKMATE, GameResult::LOSE};
         }
 
@@ -2456,7 +2488,8 @@ class Board {
 
     /**
      * @brief Checks if the game is over. Returns GameResultReason::NONE if the game is not over.
-     * This function calculates all legal moves for the current position to check if the game is over.
+     * This function stops at the first legal move it finds (see movegen::hasLegalMove),
+     * but still scans the history for repetitions.
      * If you are writing a chess engine you should not use this function.
      * @return
      */
@@ -2465,10 +2498,7 @@ class Board {
         if (isInsufficientMaterial()) return {GameResultReason::INSUFFICIENT_MATERIAL, GameResult::DRAW};
         if (isRepetition()) return {GameResultReason::THREEFOLD_REPETITION, GameResult::DRAW};
 
-        Movelist movelist;
-        movegen::legalmoves(movelist, *this);
-
-        if (movelist.empty()) {
+        if (!movegen::hasLegalMove(*this)) {
             if (inCheck()) return {GameResultReason::CHECKMATE, GameResult::LOSE};
             return {GameResultReason::STALEMATE, GameResult::DRAW};
         }
@@ -3672,7 +3702,7 @@ template <Color::underlying c>
 
 template <Color::underlying c, movegen::MoveGenType mt>
 inline void movegen::generatePawnMoves(const Board &board, Movelist &moves, Bitboard pin_d, Bitboard pin_hv,
-                                       Bitboard checkmask, Bitboard occ_opp) {
+                                       Bitboard checkmask, Bitboard occ_opp, Bitboard targets) {
     // flipped for black
 
     constexpr auto UP         = make_direction(Direction::NORTH, c);
@@ -3697,8 +3727,8 @@ inline void movegen::generatePawnMoves(const Board &board, Movelist &moves, Bitb
     auto r_pawns = attacks::shift<UP_RIGHT>(unpinned_pawns_lr) | (attacks::shift<UP_RIGHT>(pinned_pawns_lr) & pin_d);
 
     // Prune moves that don't capture a piece and are not on the checkmask.
-    l_pawns &= occ_opp & checkmask;
-    r_pawns &= occ_opp & checkmask;
+    l_pawns &= occ_opp & checkmask & targets;
+    r_pawns &= occ_opp & checkmask & targets;
 
     // These pawns can walk Forward
     const auto pawns_hv = pawns & ~pin_d;
@@ -3711,11 +3741,11 @@ inline void movegen::generatePawnMoves(const Board &board, Movelist &moves, Bitb
     const auto single_push_pinned   = attacks::shift<UP>(pawns_pinned_hv) & pin_hv & ~board.occ();
 
     // Prune moves that are not on the checkmask.
-    Bitboard single_push = (single_push_unpinned | single_push_pinned) & checkmask;
+    Bitboard single_push = (single_push_unpinned | single_push_pinned) & checkmask & targets;
 
     Bitboard double_push = ((attacks::shift<UP>(single_push_unpinned & DOUBLE_PUSH_RANK) & ~board.occ()) |
                             (attacks::shift<UP>(single_push_pinned & DOUBLE_PUSH_RANK) & ~board.occ())) &
-                           checkmask;
+                           checkmask & targets;
 
     if (pawns & RANK_B_PROMO) {
         Bitboard promo_left  = l_pawns & RANK_PROMO;
@@ -3781,7 +3811,8 @@ inline void movegen::generatePawnMoves(const Board &board, Movelist &moves, Bitb
 
     const Square ep = board.enpassantSq();
 
-    if (ep != Square::NO_SQ) {
+    // Either the en passant square or the captured pawn may be targeted.
+    if (ep != Square::NO_SQ && (targets & (Bitboard::fromSquare(ep) | Bitboard::fromSquare(ep + DOWN)))) {
         auto m = generateEPMove(board, checkmask, pin_d, pawns_lr, ep, c);
 
         for (const auto &move : m) {
@@ -3922,8 +3953,8 @@ inline void movegen::whileBitboardAdd(Movelist &movelist, Bitboard mask, T func)
     }
 }
 
-template <Color::underlying c, movegen::MoveGenType mt>
-inline void movegen::legalmoves(Movelist &movelist, const Board &board, int pieces) {
+template <Color::underlying c, movegen::MoveGenType mt, int pieces>
+inline void movegen::legalmoves(Movelist &movelist, const Board &board, int pieces_mask, Bitboard targets) {
     /*
      The size of the movelist might not
      be 0! This is done on purpose since it enables
@@ -3953,18 +3984,22 @@ inline void movegen::legalmoves(Movelist &movelist, const Board &board, int piec
     else  // QUIET moves
         movable_square = ~occ_all;
 
-    if (pieces & PieceGenType::KING) {
-        Bitboard seen = seenSquares<~c>(board, opp_empty);
+    movable_square &= targets;
 
-        whileBitboardAdd(movelist, Bitboard::fromSquare(king_sq),
-                         [&](Square sq) { return generateKingMoves(sq, seen, movable_square); });
+    if constexpr (bool(pieces & PieceGenType::KING)) {
+        if (pieces_mask & PieceGenType::KING) {
+            Bitboard seen = seenSquares<~c>(board, opp_empty);
 
-        if (mt != MoveGenType::CAPTURE && checks == 0) {
-            Bitboard moves_bb = generateCastleMoves<c>(board, king_sq, seen, pin_hv);
+            whileBitboardAdd(movelist, Bitboard::fromSquare(king_sq),
+                             [&](Square sq) { return generateKingMoves(sq, seen, movable_square); });
 
-            while (moves_bb) {
-                Square to = moves_bb.pop();
-                movelist.add(Move::make<Move::CASTLING>(king_sq, to));
+            if (mt != MoveGenType::CAPTURE && checks == 0) {
+                Bitboard moves_bb = generateCastleMoves<c>(board, king_sq, seen, pin_hv) & targets;
+
+                while (moves_bb) {
+                    Square to = moves_bb.pop();
+                    movelist.add(Move::make<Move::CASTLING>(king_sq, to));
+                }
             }
         }
     }
@@ -3976,39 +4011,51 @@ inline void movegen::legalmoves(Movelist &movelist, const Board &board, int piec
     movable_square &= checkmask;
 
     // Add the moves to the movelist.
-    if (pieces & PieceGenType::PAWN) {
-        generatePawnMoves<c, mt>(board, movelist, pin_d, pin_hv, checkmask, occ_opp);
+    if constexpr (bool(pieces & PieceGenType::PAWN)) {
+        if (pieces_mask & PieceGenType::PAWN) {
+            generatePawnMoves<c, mt>(board, movelist, pin_d, pin_hv, checkmask, occ_opp, targets);
+        }
     }
 
-    if (pieces & PieceGenType::KNIGHT) {
-        // Prune knights that are pinned since these cannot move.
-        Bitboard knights_mask = board.pieces(PieceType::KNIGHT, c) & ~(pin_d | pin_hv);
+    if constexpr (bool(pieces & PieceGenType::KNIGHT)) {
+        if (pieces_mask & PieceGenType::KNIGHT) {
+            // Prune knights that are pinned since these cannot move.
+            Bitboard knights_mask = board.pieces(PieceType::KNIGHT, c) & ~(pin_d | pin_hv);
 
-        whileBitboardAdd(movelist, knights_mask, [&](Square sq) { return generateKnightMoves(sq) & movable_square; });
+            whileBitboardAdd(movelist, knights_mask,
+                             [&](Square sq) { return generateKnightMoves(sq) & movable_square; });
+        }
     }
 
-    if (pieces & PieceGenType::BISHOP) {
-        // Prune horizontally pinned bishops
-        Bitboard bishops_mask = board.pieces(PieceType::BISHOP, c) & ~pin_hv;
+    if constexpr (bool(pieces & PieceGenType::BISHOP)) {
+        if (pieces_mask & PieceGenType::BISHOP) {
+            // Prune horizontally pinned bishops
+            Bitboard bishops_mask = board.pieces(PieceType::BISHOP, c) & ~pin_hv;
 
-        whileBitboardAdd(movelist, bishops_mask,
-                         [&](Square sq) { return generateBishopMoves(sq, pin_d, occ_all) & movable_square; });
+            whileBitboardAdd(movelist, bishops_mask,
+                             [&](Square sq) { return generateBishopMoves(sq, pin_d, occ_all) & movable_square; });
+        }
     }
 
-    if (pieces & PieceGenType::ROOK) {
-        //  Prune diagonally pinned rooks
-        Bitboard rooks_mask = board.pieces(PieceType::ROOK, c) & ~pin_d;
+    if constexpr (bool(pieces & PieceGenType::ROOK)) {
+        if (pieces_mask & PieceGenType::ROOK) {
+            //  Prune diagonally pinned rooks
+            Bitboard rooks_mask = board.pieces(PieceType::ROOK, c) & ~pin_d;
 
-        whileBitboardAdd(movelist, rooks_mask,
-                         [&](Square sq) { return generateRookMoves(sq, pin_hv, occ_all) & movable_square; });
+            whileBitboardAdd(movelist, rooks_mask,
+                             [&](Square sq) { return generateRookMoves(sq, pin_hv, occ_all) & movable_square; });
+        }
     }
 
-    if (pieces & PieceGenType::QUEEN) {
-        // Prune double pinned queens
-        Bitboard queens_mask = board.pieces(PieceType::QUEEN, c) & ~(pin_d & pin_hv);
+    if constexpr (bool(pieces & PieceGenType::QUEEN)) {
+        if (pieces_mask & PieceGenType::QUEEN) {
+            // Prune double pinned queens
+            Bitboard queens_mask = board.pieces(PieceType::QUEEN, c) & ~(pin_d & pin_hv);
 
-        whileBitboardAdd(movelist, queens_mask,
-                         [&](Square sq) { return generateQueenMoves(sq, pin_d, pin_hv, occ_all) & movable_square; });
+            whileBitboardAdd(movelist, queens_mask, [&](Square sq) {
+                return generateQueenMoves(sq, pin_d, pin_hv, occ_all) & movable_square;
+            });
+        }
     }
 }
 
@@ -4017,9 +4064,134 @@ inline void movegen::legalmoves(Movelist &movelist, const Board &board, int piec
     movelist.clear();
 
     if (board.sideToMove() == Color::WHITE)
-        legalmoves<Color::WHITE, mt>(movelist, board, pieces);
+        legalmoves<Color::WHITE, mt, ALL_PIECES>(movelist, board, pieces, ~0ull);
+    else
+        legalmoves<Color::BLACK, mt, ALL_PIECES>(movelist, board, pieces, ~0ull);
+}
+
+template <movegen::MoveGenType mt, int pieces>
+inline void movegen::legalmoves(Movelist &movelist, const Board &board, Bitboard targets) {
+    static_assert((pieces & ~ALL_PIECES) == 0, "pieces must be a combination of PieceGenType values");
+
+    movelist.clear();
+
+    if (board.sideToMove() == Color::WHITE)
+        legalmoves<Color::WHITE, mt, pieces>(movelist, board, pieces, targets);
+    else
+        legalmoves<Color::BLACK, mt, pieces>(movelist, board, pieces, targets);
+}
+
+template <Color::underlying c>
+[[nodiscard]] inline bool movegen::hasPawnMove(const Board &board, Bitboard pin_d, Bitboard pin_hv,
+                                               Bitboard checkmask, Bitboard occ_opp) {
+    // Same masks as generatePawnMoves, but only tested for emptiness.
+    constexpr auto UP       = make_direction(Direction::NORTH, c);
+    constexpr auto UP_LEFT  = make_direction(Direction::NORTH_WEST, c);
+    constexpr auto UP_RIGHT = make_direction(Direction::NORTH_EAST, c);
+
+    constexpr auto DOUBLE_PUSH_RANK = Rank::rank(Rank::RANK_3, c).bb();
+
+    const auto pawns = board.pieces(PieceType::PAWN, c);
+
+    const Bitboard pawns_lr          = pawns & ~pin_hv;
+    const Bitboard unpinned_pawns_lr = pawns_lr & ~pin_d;
+    const Bitboard pinned_pawns_lr   = pawns_lr & pin_d;
+
+    const auto captures =
+        (attacks::shift<UP_LEFT>(unpinned_pawns_lr) | attacks::shift<UP_RIGHT>(unpinned_pawns_lr) |
+         ((attacks::shift<UP_LEFT>(pinned_pawns_lr) | attacks::shift<UP_RIGHT>(pinned_pawns_lr)) & pin_d)) &
+        occ_opp & checkmask;
+
+    if (captures) return true;
+
+    const auto pawns_hv = pawns & ~pin_d;
+
+    const auto single_push_unpinned = attacks::shift<UP>(pawns_hv & ~pin_hv) & ~board.occ();
+    const auto single_push_pinned   = attacks::shift<UP>(pawns_hv & pin_hv) & pin_hv & ~board.occ();
+    const auto single_push          = single_push_unpinned | single_push_pinned;
+
+    if (single_push & checkmask) return true;
+
+    if (attacks::shift<UP>(single_push & DOUBLE_PUSH_RANK) & ~board.occ() & checkmask) return true;
+
+    const Square ep = board.enpassantSq();
+
+    if (ep == Square::NO_SQ) return false;
+
+    const auto m = generateEPMove(board, checkmask, pin_d, pawns_lr, ep, c);
+
+    return m[0] != Move::NO_MOVE;
+}
+
+template <Color::underlying c>
+[[nodiscard]] inline bool movegen::hasLegalMove(const Board &board) {
+    const auto king_sq = board.kingSq(c);
+
+    const Bitboard occ_us  = board.us(c);
+    const Bitboard occ_opp = board.us(~c);
+    const Bitboard occ_all = occ_us | occ_opp;
+
+    const Bitboard opp_empty = ~occ_us;
+
+    const auto [checkmask, checks] = checkMask<c>(board, king_sq);
+
+    assert(checks <= 2);
+
+    // King moves ignore the checkmask and need no pin information.
+    const Bitboard seen = seenSquares<~c>(board, opp_empty);
+
+    if (generateKingMoves(king_sq, seen, opp_empty)) return true;
+
+    // Only the king can escape a double check.
+    if (checks == 2) return false;
+
+    const auto pin_hv = pinMask<c, PieceType::ROOK>(board, king_sq, occ_opp, occ_us);
+    const auto pin_d  = pinMask<c, PieceType::BISHOP>(board, king_sq, occ_opp, occ_us);
+
+    const Bitboard movable_square = opp_empty & checkmask;
+    const Bitboard unpinned       = ~(pin_d | pin_hv);
+
+    if (hasPawnMove<c>(board, pin_d, pin_hv, checkmask, occ_opp)) return true;
+
+    // Pinned knights can never move.
+    Bitboard knights = board.pieces(PieceType::KNIGHT, c) & unpinned;
+
+    while (knights) {
+        if (generateKnightMoves(knights.pop()) & movable_square) return true;
+    }
+
+    const auto has_slider_move = [&](Bitboard mask) {
+        Bitboard bishops = board.pieces(PieceType::BISHOP, c) & ~pin_hv & mask;
+        Bitboard rooks   = board.pieces(PieceType::ROOK, c) & ~pin_d & mask;
+        Bitboard queens  = board.pieces(PieceType::QUEEN, c) & ~(pin_d & pin_hv) & mask;
+
+        while (bishops) {
+            if (generateBishopMoves(bishops.pop(), pin_d, occ_all) & movable_square) return true;
+        }
+
+        while (rooks) {
+            if (generateRookMoves(rooks.pop(), pin_hv, occ_all) & movable_square) return true;
+        }
+
+        while (queens) {
+            if (generateQueenMoves(queens.pop(), pin_d, pin_hv, occ_all) & movable_square) return true;
+        }
+
+        return false;
+    };
+
+    // Unpinned sliders are far more likely to have a move than pinned ones.
+    if (has_slider_move(unpinned) || has_slider_move(~unpinned)) return true;
+
+    // Castling last, it only matters when the king has no regular move (Chess960).
+    return checks == 0 && generateCastleMoves<c>(board, king_sq, seen, pin_hv);
+}
+
+inline bool movegen::hasLegalMove(const Board &board) {
+    if (board.sideToMove() == Color::WHITE)
+        return hasLegalMove<Color::WHITE>(board);
     else
-        legalmoves<Color::BLACK, mt>(movelist, board, pieces);
+        return hasLegalMove<Color::BLACK>(board);
 }
 
 template <Color::underlying c>
@@ -4963,13 +5135,16 @@ class uci {
             return Move::NO_MOVE;
         }
 
-        static constexpr auto pt_to_pgt = [](PieceType pt) { return 1 << (pt); };
-        const SanMoveInformation info   = parseSanInfo(san);
+        const SanMoveInformation info = parseSanInfo(san);
+
+        // castling is encoded as king takes rook, so it can't be restricted to the san destination
+        const auto castling = info.castling_short || info.castling_long;
+        const auto targets  = castling || info.to == Square::NO_SQ ? Bitboard(~0ull) : Bitboard::fromSquare(info.to);
 
         if (info.capture) {
-            movegen::legalmoves<movegen::MoveGenType::CAPTURE>(moves, board, pt_to_pgt(info.piece));
+            legalmovesTo<movegen::MoveGenType::CAPTURE>(moves, board, info.piece, targets);
         } else {
-            movegen::legalmoves<movegen::MoveGenType::QUIET>(moves, board, pt_to_pgt(info.piece));
+            legalmovesTo<movegen::MoveGenType::QUIET>(moves, board, info.piece, targets);
         }
 
         if (info.castling_short || info.castling_long) {
@@ -5273,13 +5448,35 @@ class uci {
     }
 
     static void appendCheckSymbol(Board &board, std::string &str) {
-        const auto gameState = board.isGameOver().second;
-        str += (gameState == GameResult::LOSE) ? '#' : '+';
+        // only called when in check, so no legal move means checkmate
+        str += movegen::hasLegalMove(board) ? '+' : '#';
+    }
+
+    // Dispatches a runtime piece type to the compile time piece mask of movegen::legalmoves.
+    template <movegen::MoveGenType mt>
+    static void legalmovesTo(Movelist &moves, const Board &board, PieceType pt, Bitboard targets) {
+        switch (pt.internal()) {
+            case PieceType::PAWN:
+                return movegen::legalmoves<mt, PieceGenType::PAWN>(moves, board, targets);
+            case PieceType::KNIGHT:
+                return movegen::legalmoves<mt, PieceGenType::KNIGHT>(moves, board, targets);
+            case PieceType::BISHOP:
+                return movegen::legalmoves<mt, PieceGenType::BISHOP>(moves, board, targets);
+            case PieceType::ROOK:
+                return movegen::legalmoves<mt, PieceGenType::ROOK>(moves, board, targets);
+            case PieceType::QUEEN:
+                return movegen::legalmoves<mt, PieceGenType::QUEEN>(moves, board, targets);
+            case PieceType::KING:
+                return movegen::legalmoves<mt, PieceGenType::KING>(moves, board, targets);
+            default:
+                moves.clear();
+        }
     }
 
     static void resolveAmbiguity(const Board &board, const Move &move, PieceType pieceType, std::string &str) {
+        // only moves to the same square can be ambiguous
         Movelist moves;
-        movegen::legalmoves(moves, board, 1 << pieceType);
+        legalmovesTo<movegen::MoveGenType::ALL>(moves, board, pieceType, Bitboard::fromSquare(move.to()));
 
         bool needFile         = false;
         bool needRank         = false;
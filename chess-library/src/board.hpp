@@ -714,10 +714,7 @@ class Board {
      * @return
      */
     [[nodiscard]] std::pair<GameResultReason, GameResult> getHalfMoveDrawType() const noexcept {
-        Movelist movelist;
-        movegen::legalmoves(movelist, *this);
-
-        if (movelist.empty() && inCheck()) {
+        if (inCheck() && !movegen::hasLegalMove(*this)) {
             return {GameResultReason::CHECKMATE, GameResult::LOSE};
         }
 
@@ -763,7 +760,8 @@ class Board {
 
     /**
      * @brief Checks if the game is over. Returns GameResultReason::NONE if the game is not over.
-     * This function calculates all legal moves for the current position to check if the game is over.
+     * This function stops at the first legal move it finds (see movegen::hasLegalMove),
+     * but still scans the history for repetitions.
      * If you are writing a chess engine you should not use this function.
      * @return
      */
@@ -772,10 +770,7 @@ class Board {
         if (isInsufficientMaterial()) return {GameResultReason::INSUFFICIENT_MATERIAL, GameResult::DRAW};
         if (isRepetition()) return {GameResultReason::THREEFOLD_REPETITION, GameResult::DRAW};
 
-        Movelist movelist;
-        movegen::legalmoves(movelist, *this);
-
-        if (movelist.empty()) {
+        if (!movegen::hasLegalMove(*this)) {
             if (inCheck()) return {GameResultReason::CHECKMATE, GameResult::LOSE};
             return {GameResultReason::STALEMATE, GameResult::DRAW};
         }
@@ -34,7 +34,34 @@ class movegen {
                            int pieces = PieceGenType::PAWN | PieceGenType::KNIGHT | PieceGenType::BISHOP |
                                         PieceGenType::ROOK | PieceGenType::QUEEN | PieceGenType::KING);
 
+    /**
+     * @brief Generates all legal moves for a position whose destination square is in targets.
+     * En passant is included if either the en passant square or the captured pawn is in targets,
+     * castling if the rook square is.
+     * @tparam mt
+     * @tparam pieces PieceGenType mask, piece types not in the mask are compiled out.
+     * @param movelist
+     * @param board
+     * @param targets
+     */
+    template <MoveGenType mt = MoveGenType::ALL,
+              int pieces     = PieceGenType::PAWN | PieceGenType::KNIGHT | PieceGenType::BISHOP | PieceGenType::ROOK |
+                           PieceGenType::QUEEN | PieceGenType::KING>
+    void static legalmoves(Movelist &movelist, const Board &board, Bitboard targets);
+
+    /**
+     * @brief Checks if the side to move has at least one legal move.
+     * Returns on the first legal move found instead of generating the full movelist,
+     * trying king moves first, then unpinned pieces and finally pinned pieces.
+     * @param board
+     * @return
+     */
+    [[nodiscard]] static bool hasLegalMove(const Board &board);
+
    private:
+    static constexpr int ALL_PIECES = PieceGenType::PAWN | PieceGenType::KNIGHT | PieceGenType::BISHOP |
+                                      PieceGenType::ROOK | PieceGenType::QUEEN | PieceGenType::KING;
+
     static auto init_squares_between();
     static const std::array<std::array<Bitboard, 64>, 64> SQUARES_BETWEEN_BB;
 
@@ -55,7 +82,7 @@ class movegen {
     // Generate pawn moves.
     template <Color::underlying c, MoveGenType mt>
     static void generatePawnMoves(const Board &board, Movelist &moves, Bitboard pin_d, Bitboard pin_hv,
-                                  Bitboard checkmask, Bitboard occ_enemy);
+                                  Bitboard checkmask, Bitboard occ_enemy, Bitboard targets);
 
     [[nodiscard]] static std::array<Move, 2> generateEPMove(const Board &board, Bitboard checkmask, Bitboard pin_d,
                                                             Bitboard pawns_lr, Square ep, Color c);
@@ -76,8 +103,16 @@ class movegen {
     template <typename T>
     static void whileBitboardAdd(Movelist &movelist, Bitboard mask, T func);
 
-    template <Color::underlying c, MoveGenType mt>
-    static void legalmoves(Movelist &movelist, const Board &board, int pieces);
+    // pieces is checked at compile time, pieces_mask at runtime. Only types in both are generated.
+    template <Color::underlying c, MoveGenType mt, int pieces>
+    static void legalmoves(Movelist &movelist, const Board &board, int pieces_mask, Bitboard targets);
+
+    template <Color::underlying c>
+    [[nodiscard]] static bool hasPawnMove(const Board &board, Bitboard pin_d, Bitboard pin_hv, Bitboard checkmask,
+                                          Bitboard occ_opp);
+
+    template <Color::underlying c>
+    [[nodiscard]] static bool hasLegalMove(const Board &board);
 
     template <Color::underlying c>
     static bool isEpSquareValid(const Board &board, Square ep);
@@ -174,13 +174,16 @@ class uci {
             return Move::NO_MOVE;
         }
 
-        static constexpr auto pt_to_pgt = [](PieceType pt) { return 1 << (pt); };
-        const SanMoveInformation info   = parseSanInfo(san);
+        const SanMoveInformation info = parseSanInfo(san);
+
+        // castling is encoded as king takes rook, so it can't be restricted to the san destination
+        const auto castling = info.castling_short || info.castling_long;
+        const auto targets  = castling || info.to == Square::NO_SQ ? Bitboard(~0ull) : Bitboard::fromSquare(info.to);
 
         if (info.capture) {
-            movegen::legalmoves<movegen::MoveGenType::CAPTURE>(moves, board, pt_to_pgt(info.piece));
+            legalmovesTo<movegen::MoveGenType::CAPTURE>(moves, board, info.piece, targets);
         } else {
-            movegen::legalmoves<movegen::MoveGenType::QUIET>(moves, board, pt_to_pgt(info.piece));
+            legalmovesTo<movegen::MoveGenType::QUIET>(moves, board, info.piece, targets);
         }
 
         if (info.castling_short || info.castling_long) {
@@ -484,13 +487,35 @@ class uci {
     }
 
     static void appendCheckSymbol(Board &board, std::string &str) {
-        const auto gameState = board.isGameOver().second;
-        str += (gameState == GameResult::LOSE) ? '#' : '+';
+        // only called when in check, so no legal move means checkmate
+        str += movegen::hasLegalMove(board) ? '+' : '#';
+    }
+
+    // Dispatches a runtime piece type to the compile time piece mask of movegen::legalmoves.
+    template <movegen::MoveGenType mt>
+    static void legalmovesTo(Movelist &moves, const Board &board, PieceType pt, Bitboard targets) {
+        switch (pt.internal()) {
+            case PieceType::PAWN:
+                return movegen::legalmoves<mt, PieceGenType::PAWN>(moves, board, targets);
+            case PieceType::KNIGHT:
+                return movegen::legalmoves<mt, PieceGenType::KNIGHT>(moves, board, targets);
+            case PieceType::BISHOP:
+                return movegen::legalmoves<mt, PieceGenType::BISHOP>(moves, board, targets);
+            case PieceType::ROOK:
+                return movegen::legalmoves<mt, PieceGenType::ROOK>(moves, board, targets);
+            case PieceType::QUEEN:
+                return movegen::legalmoves<mt, PieceGenType::QUEEN>(moves, board, targets);
+            case PieceType::KING:
+                return movegen::legalmoves<mt, PieceGenType::KING>(moves, board, targets);
+            default:
+                moves.clear();
+        }
     }
 
     static void resolveAmbiguity(const Board &board, const Move &move, PieceType pieceType, std::string &str) {
+        // only moves to the same square can be ambiguous
         Movelist moves;
-        movegen::legalmoves(moves, board, 1 << pieceType);
+        legalmovesTo<movegen::MoveGenType::ALL>(moves, board, pieceType, Bitboard::fromSquare(move.to()));
 
         bool needFile         = false;
         bool needRank         = false;
@@ -0,0 +1,152 @@
+#include "../src/include.hpp"
+#include "doctest/doctest.hpp"
+
+using namespace chess;
+
+namespace {
+// Walks the tree and compares hasLegalMove against the full move generator at every node.
+void checkHasLegalMove(Board& board, int depth) {
+    Movelist moves;
+    movegen::legalmoves(moves, board);
+
+    CHECK(movegen::hasLegalMove(board) == !moves.empty());
+
+    if (depth == 0) return;
+
+    for (const auto& move : moves) {
+        board.makeMove(move);
+        checkHasLegalMove(board, depth - 1);
+        board.unmakeMove(move);
+    }
+}
+
+// Generating captures victim by victim must yield exactly the captures of a single call.
+void checkTargetedCaptures(Board& board, int depth) {
+    Movelist captures;
+    movegen::legalmoves<movegen::MoveGenType::CAPTURE>(captures, board);
+
+    int staged = 0;
+
+    for (const auto pt : {PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT, PieceType::PAWN}) {
+        Movelist moves;
+        movegen::legalmoves<movegen::MoveGenType::CAPTURE>(moves, board, board.pieces(pt, ~board.sideToMove()));
+
+        for (const auto& move : moves) {
+            CHECK(std::find(captures.begin(), captures.end(), move) != captures.end());
+        }
+
+        staged += moves.size();
+    }
+
+    CHECK(staged == captures.size());
+
+    if (depth == 0) return;
+
+    Movelist moves;
+    movegen::legalmoves(moves, board);
+
+    for (const auto& move : moves) {
+        board.makeMove(move);
+        checkTargetedCaptures(board, depth - 1);
+        board.unmakeMove(move);
+    }
+}
+}  // namespace
+
+TEST_SUITE("Movegen") {
+    TEST_CASE("hasLegalMove Checkmate") {
+        Board board = Board("rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3");
+
+        CHECK(movegen::hasLegalMove(board) == false);
+        CHECK(board.isGameOver() == std::pair(GameResultReason::CHECKMATE, GameResult::LOSE));
+    }
+
+    TEST_CASE("hasLegalMove Stalemate") {
+        Board board = Board("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1");
+
+        CHECK(movegen::hasLegalMove(board) == false);
+        CHECK(board.isGameOver() == std::pair(GameResultReason::STALEMATE, GameResult::DRAW));
+    }
+
+    TEST_CASE("hasLegalMove matches legalmoves") {
+        const std::string fens[] = {
+            "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ",
+            "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ",
+            "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+            "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        };
+
+        for (const auto& fen : fens) {
+            Board board(fen);
+            checkHasLegalMove(board, 3);
+        }
+    }
+
+    TEST_CASE("hasLegalMove matches legalmoves FRC") {
+        const std::string fens[] = {
+            "1rqbkrbn/1ppppp1p/1n6/p1N3p1/8/2P4P/PP1PPPP1/1RQBKRBN w FBfb - 0 9",
+            "rr6/2kpp3/1ppn2p1/p2b1q1p/P4P1P/1PNN2P1/2PP4/1K2R2R b E - 1 20",
+        };
+
+        for (const auto& fen : fens) {
+            Board board(fen);
+            board.set960(true);
+            checkHasLegalMove(board, 3);
+        }
+    }
+
+    TEST_CASE("legalmoves with targets matches staged captures") {
+        const std::string fens[] = {
+            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ",
+            "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ",
+            "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        };
+
+        for (const auto& fen : fens) {
+            Board board(fen);
+            checkTargetedCaptures(board, 2);
+        }
+    }
+
+    TEST_CASE("legalmoves with targets single square") {
+        Board board = Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ");
+
+        Movelist all;
+        movegen::legalmoves(all, board);
+
+        for (int sq = 0; sq < 64; sq++) {
+            Movelist moves;
+            movegen::legalmoves(moves, board, Bitboard::fromSquare(sq));
+
+            int expected = 0;
+            for (const auto& move : all) expected += move.to() == Square(sq);
+
+            CHECK(moves.size() == expected);
+        }
+    }
+
+    TEST_CASE("legalmoves with targets compile time pieces") {
+        Board board = Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ");
+
+        Movelist moves;
+        movegen::legalmoves<movegen::MoveGenType::CAPTURE, PieceGenType::KNIGHT>(moves, board,
+                                                                                board.us(Color::BLACK));
+
+        CHECK(moves.size() == 3);
+        CHECK(std::find(moves.begin(), moves.end(), Move::make(Square::SQ_E5, Square::SQ_D7)) != moves.end());
+        CHECK(std::find(moves.begin(), moves.end(), Move::make(Square::SQ_E5, Square::SQ_F7)) != moves.end());
+        CHECK(std::find(moves.begin(), moves.end(), Move::make(Square::SQ_E5, Square::SQ_G6)) != moves.end());
+    }
+
+    TEST_CASE("legalmoves with targets en passant") {
+        Board board = Board("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3");
+
+        Movelist moves;
+        movegen::legalmoves<movegen::MoveGenType::CAPTURE, PieceGenType::PAWN>(moves, board,
+                                                                              Bitboard::fromSquare(Square::SQ_F5));
+
+        CHECK(moves.size() == 1);
+        CHECK(moves[0] == Move::make<Move::ENPASSANT>(Square::SQ_E5, Square::SQ_F6));
+    }
+}
@@ -0,0 +1,474 @@
+// ============================================================================
+// PestoPasta Dataset Shuffler
+// Out-of-core shuffle and sampling for packed position datasets
+//
+// Datasets are flat files of fixed-size records, each starting with a
+// 24-byte Board::Compact position (extra bytes such as scores or results
+// are carried along untouched). Datasets written from games are ordered by
+// game and usually larger than RAM, so the shuffle runs in two passes:
+//   1. Scatter: every record is sent to a random bucket file on disk
+//   2. Shuffle: each bucket is mapped into memory, shuffled and written to
+//      its slot in the output file
+// Random bucket sizes plus a uniform shuffle inside each bucket give a
+// uniformly random permutation of the kept records.
+//
+// Records can be subsampled uniformly (--sample), weighted by game phase
+// (--phase-weights) or stratified so every phase group contributes about
+// the same number of records (--stratify-phase, adds a counting pass).
+//
+// POSIX only (pread/pwrite/mmap)
+// Compile: g++ -O3 -std=c++17 -pthread -I./chess-library/include -o dataset_shuffle dataset_shuffle.cpp
+// Usage:   ./dataset_shuffle --in games.bin --out shuffled.bin --threads 8 --memory 4096
+// ============================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "chess.hpp"
+
+using namespace chess;
+
+const int MAX_PHASE = 24;            // Same scale as Engine::calculate_phase (24 = opening)
+const int MAX_BUCKETS = 1000;        // Bucket files stay open during the scatter pass
+const size_t READ_BLOCK = 4 << 20;   // Bytes read per pread in the scatter pass
+
+struct ShuffleOptions {
+    std::string in;
+    std::string out;
+    std::string tmp = ".";
+    size_t record_size = sizeof(PackedBoard);
+    int threads = 1;
+    size_t memory_mb = 1024;           // Budget for the shuffle pass (all threads)
+    uint64_t seed = 0;
+    double sample = 1.0;               // Keep probability for every record
+    std::vector<double> phase_weights; // Keep probability per phase group
+    int stratify_groups = 0;           // > 0: equalize kept records per phase group
+};
+
+void print_usage() {
+    std::cerr << "Usage: dataset_shuffle --in FILE --out FILE [options]\n"
+              << "  --record-size N      bytes per record, first 24 are Board::Compact (default 24)\n"
+              << "  --threads N          I/O and shuffle threads (default 1)\n"
+              << "  --memory MB          memory budget for the shuffle pass (default 1024)\n"
+              << "  --tmp DIR            parent of the per-run bucket directory (default .)\n"
+              << "  --seed N             random seed (default 0)\n"
+              << "  --sample F           keep each record with probability F (default 1)\n"
+              << "  --phase-weights W,.. keep probability per phase group, endgame first\n"
+              << "  --stratify-phase N   keep about the same number of records in N phase groups\n";
+}
+
+bool parse_args(int argc, char* argv[], ShuffleOptions& opts) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") return false;
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+
+        std::string value = argv[++i];
+        try {
+            if (arg == "--in") opts.in = value;
+            else if (arg == "--out") opts.out = value;
+            else if (arg == "--tmp") opts.tmp = value;
+            else if (arg == "--record-size") opts.record_size = std::stoul(value);
+            else if (arg == "--threads") opts.threads = std::max(1, std::stoi(value));
+            else if (arg == "--memory") opts.memory_mb = std::stoul(value);
+            else if (arg == "--seed") opts.seed = std::stoull(value);
+            else if (arg == "--sample") opts.sample = std::stod(value);
+            else if (arg == "--stratify-phase") opts.stratify_groups = std::stoi(value);
+            else if (arg == "--phase-weights") {
+                std::istringstream iss(value);
+                std::string weight;
+                while (std::getline(iss, weight, ',')) opts.phase_weights.push_back(std::stod(weight));
+            }
+            else {
+                std::cerr << "Unknown option " << arg << "\n";
+                return false;
+            }
+        } catch (const std::exception&) {
+            // std::stoul/stod and friends throw on non-numeric or out-of-range input
+            std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+            return false;
+        }
+    }
+
+    if (opts.in.empty() || opts.out.empty()) {
+        std::cerr << "--in and --out are required\n";
+        return false;
+    }
+    if (opts.record_size < sizeof(PackedBoard)) {
+        std::cerr << "--record-size must be at least " << sizeof(PackedBoard) << "\n";
+        return false;
+    }
+    // Written as !(in range) so NaN is rejected too
+    if (!(opts.sample >= 0.0 && opts.sample <= 1.0)) {
+        std::cerr << "--sample must be between 0 and 1\n";
+        return false;
+    }
+    for (double w : opts.phase_weights) {
+        if (!(w >= 0.0 && w <= 1.0)) {
+            std::cerr << "--phase-weights entries must be between 0 and 1\n";
+            return false;
+        }
+    }
+    if (opts.stratify_groups < 0) {
+        std::cerr << "--stratify-phase must not be negative\n";
+        return false;
+    }
+    if (!opts.phase_weights.empty() && opts.stratify_groups > 0) {
+        std::cerr << "--phase-weights and --stratify-phase are exclusive\n";
+        return false;
+    }
+    if (opts.stratify_groups > MAX_PHASE + 1) {
+        std::cerr << "--stratify-phase allows at most " << MAX_PHASE + 1 << " groups\n";
+        return false;
+    }
+    return true;
+}
+
+// Game phase of a packed record (0 = endgame, 24 = opening), same weights as the engine
+int record_phase(const uint8_t* record) {
+    PackedBoard packed;
+    std::memcpy(packed.data(), record, packed.size());
+    Board board = Board::Compact::decode(packed);
+
+    int phase = board.pieces(PieceType::KNIGHT).count() + board.pieces(PieceType::BISHOP).count() +
+                2 * board.pieces(PieceType::ROOK).count() + 4 * board.pieces(PieceType::QUEEN).count();
+    return std::min(phase, MAX_PHASE);
+}
+
+// Maps a phase to one of `groups` equal-width groups, endgame first
+int phase_group(int phase, int groups) {
+    return std::min(groups - 1, phase * groups / (MAX_PHASE + 1));
+}
+
+// pread/pwrite may transfer less than asked, loop until done
+bool read_full(int fd, uint8_t* buf, size_t size, uint64_t offset) {
+    while (size > 0) {
+        ssize_t n = pread(fd, buf, size, offset);
+        if (n <= 0) return false;
+        buf += n;
+        size -= n;
+        offset += n;
+    }
+    return true;
+}
+
+bool write_full(int fd, const uint8_t* buf, size_t size, uint64_t offset) {
+    while (size > 0) {
+        ssize_t n = pwrite(fd, buf, size, offset);
+        if (n <= 0) return false;
+        buf += n;
+        size -= n;
+        offset += n;
+    }
+    return true;
+}
+
+// Runs func(thread_id, first_record, end_record) on an even split of the input
+template <typename F>
+void for_each_range(uint64_t records, int threads, F func) {
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        uint64_t begin = records * t / threads;
+        uint64_t end = records * (t + 1) / threads;
+        workers.emplace_back(func, t, begin, end);
+    }
+    for (auto& w : workers) w.join();
+}
+
+// Calls func(record) for every record in [begin, end), reading in large blocks
+template <typename F>
+bool scan_records(int fd, size_t record_size, uint64_t begin, uint64_t end, F func) {
+    const uint64_t block_records = std::max<uint64_t>(1, READ_BLOCK / record_size);
+    std::vector<uint8_t> block(block_records * record_size);
+
+    for (uint64_t r = begin; r < end; r += block_records) {
+        uint64_t n = std::min(block_records, end - r);
+        if (!read_full(fd, block.data(), n * record_size, r * record_size)) return false;
+
+        for (uint64_t i = 0; i < n; i++) func(block.data() + i * record_size);
+    }
+    return true;
+}
+
+// Per-run scratch directory for bucket files, removed with its contents on every exit path
+// A unique directory keeps concurrent runs sharing --tmp from truncating each other's buckets
+struct ScratchDir {
+    std::string path;
+    std::vector<std::string> files;
+
+    bool create(const std::string& parent) {
+        std::string pattern = parent + "/shuffle_XXXXXX";
+        if (mkdtemp(pattern.data()) == nullptr) return false;
+        path = pattern;
+        return true;
+    }
+
+    std::string file(const std::string& name) {
+        files.push_back(path + "/" + name);
+        return files.back();
+    }
+
+    ~ScratchDir() {
+        if (path.empty()) return;
+        for (const auto& f : files) unlink(f.c_str());
+        rmdir(path.c_str());
+    }
+};
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    ShuffleOptions opts;
+    if (!parse_args(argc, argv, opts)) {
+        print_usage();
+        return 1;
+    }
+
+    int in_fd = open(opts.in.c_str(), O_RDONLY);
+    if (in_fd < 0) {
+        std::cerr << "Could not open " << opts.in << "\n";
+        return 1;
+    }
+
+    struct stat st;
+    if (fstat(in_fd, &st) != 0) {
+        std::cerr << "Could not stat " << opts.in << "\n";
+        return 1;
+    }
+    const uint64_t records = st.st_size / opts.record_size;
+    if (st.st_size % opts.record_size != 0) {
+        std::cerr << "Warning: " << st.st_size % opts.record_size << " trailing bytes ignored\n";
+    }
+
+    // ------------------------------------------------------------------------
+    // Keep probability per phase (all 1 when no phase sampling is requested)
+    // ------------------------------------------------------------------------
+    std::vector<double> keep(MAX_PHASE + 1, opts.sample);
+    const bool needs_phase = !opts.phase_weights.empty() || opts.stratify_groups > 0;
+
+    if (!opts.phase_weights.empty()) {
+        int groups = opts.phase_weights.size();
+        for (int p = 0; p <= MAX_PHASE; p++) keep[p] *= opts.phase_weights[phase_group(p, groups)];
+    }
+
+    if (opts.stratify_groups > 0) {
+        // Counting pass: the smallest group sets how many records every group keeps
+        auto start = std::chrono::steady_clock::now();
+        int groups = opts.stratify_groups;
+        std::vector<std::vector<uint64_t>> counts(opts.threads, std::vector<uint64_t>(groups, 0));
+        std::atomic<bool> ok{true};
+
+        for_each_range(records, opts.threads, [&](int t, uint64_t begin, uint64_t end) {
+            bool read_ok = scan_records(in_fd, opts.record_size, begin, end, [&](const uint8_t* record) {
+                counts[t][phase_group(record_phase(record), groups)]++;
+            });
+            if (!read_ok) ok = false;
+        });
+        if (!ok) {
+            std::cerr << "Read error on " << opts.in << "\n";
+            return 1;
+        }
+
+        std::vector<uint64_t> total(groups, 0);
+        for (const auto& c : counts)
+            for (int g = 0; g < groups; g++) total[g] += c[g];
+
+        uint64_t smallest = UINT64_MAX;
+        for (auto n : total)
+            if (n > 0) smallest = std::min(smallest, n);
+
+        for (int p = 0; p <= MAX_PHASE; p++) {
+            uint64_t n = total[phase_group(p, groups)];
+            keep[p] *= n > 0 ? double(smallest) / n : 0.0;
+        }
+
+        std::cerr << "Count pass: " << seconds_since(start) << "s, records per phase group:";
+        for (auto n : total) std::cerr << " " << n;
+        std::cerr << "\n";
+    }
+
+    const double max_keep = *std::max_element(keep.begin(), keep.end());
+
+    // ------------------------------------------------------------------------
+    // Pass 1: scatter records into random bucket files
+    // ------------------------------------------------------------------------
+    // Buckets are sized so that one per thread fits in the memory budget, with headroom for
+    // the random spread of bucket sizes
+    const uint64_t memory = uint64_t(opts.memory_mb) << 20;
+    const uint64_t expected_bytes = uint64_t(records * max_keep) * opts.record_size;
+    const uint64_t bucket_target = std::max<uint64_t>(opts.record_size, memory / opts.threads);
+    const uint64_t buckets = std::max<uint64_t>(1, (expected_bytes + expected_bytes / 4) / bucket_target + 1);
+
+    if (buckets > (uint64_t)MAX_BUCKETS) {
+        std::cerr << "Dataset needs " << buckets << " buckets, raise --memory (max " << MAX_BUCKETS << ")\n";
+        return 1;
+    }
+
+    ScratchDir scratch;
+    if (!scratch.create(opts.tmp)) {
+        std::cerr << "Could not create a scratch directory in " << opts.tmp << "\n";
+        return 1;
+    }
+
+    // Open the output before the scatter pass so a bad --out fails before any heavy I/O
+    int out_fd = open(opts.out.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out_fd < 0) {
+        std::cerr << "Could not create " << opts.out << "\n";
+        return 1;
+    }
+
+    std::vector<std::string> bucket_paths(buckets);
+    std::vector<int> bucket_fds(buckets, -1);
+    std::vector<std::mutex> bucket_locks(buckets);
+    std::vector<uint64_t> bucket_bytes(buckets, 0);
+
+    for (uint64_t b = 0; b < buckets; b++) {
+        bucket_paths[b] = scratch.file("bucket_" + std::to_string(b) + ".bin");
+        bucket_fds[b] = open(bucket_paths[b].c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (bucket_fds[b] < 0) {
+            std::cerr << "Could not create " << bucket_paths[b] << "\n";
+            return 1;
+        }
+    }
+
+    // Each thread buffers records per bucket, a quarter of the budget is spread over all buffers
+    const uint64_t buffer_records = std::clamp<uint64_t>(
+        memory / 4 / (opts.threads * buckets * opts.record_size), 1, (1 << 20) / opts.record_size);
+
+    auto scatter_start = std::chrono::steady_clock::now();
+    std::atomic<uint64_t> kept{0};
+    std::atomic<bool> ok{true};
+
+    for_each_range(records, opts.threads, [&](int t, uint64_t begin, uint64_t end) {
+        std::mt19937_64 rng(opts.seed * 1000003ULL + t);
+        std::uniform_int_distribution<uint64_t> pick_bucket(0, buckets - 1);
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+
+        std::vector<std::vector<uint8_t>> buffers(buckets);
+        for (auto& buf : buffers) buf.reserve(buffer_records * opts.record_size);
+
+        auto flush = [&](uint64_t b) {
+            std::lock_guard<std::mutex> lock(bucket_locks[b]);
+            if (!write_full(bucket_fds[b], buffers[b].data(), buffers[b].size(), bucket_bytes[b])) ok = false;
+            bucket_bytes[b] += buffers[b].size();
+            buffers[b].clear();
+        };
+
+        uint64_t thread_kept = 0;
+
+        bool read_ok = scan_records(in_fd, opts.record_size, begin, end, [&](const uint8_t* record) {
+            double p = needs_phase ? keep[record_phase(record)] : opts.sample;
+            if (p < 1.0 && coin(rng) >= p) return;
+
+            uint64_t b = pick_bucket(rng);
+            buffers[b].insert(buffers[b].end(), record, record + opts.record_size);
+            thread_kept++;
+
+            if (buffers[b].size() >= buffer_records * opts.record_size) flush(b);
+        });
+
+        for (uint64_t b = 0; b < buckets; b++) {
+            if (!buffers[b].empty()) flush(b);
+        }
+
+        kept += thread_kept;
+        if (!read_ok) ok = false;
+    });
+
+    for (int fd : bucket_fds) close(fd);
+    close(in_fd);
+
+    if (!ok) {
+        std::cerr << "I/O error during scatter pass\n";
+        return 1;
+    }
+
+    std::cerr << "Scatter pass: " << seconds_since(scatter_start) << "s, kept " << kept << "/" << records
+              << " records in " << buckets << " buckets\n";
+
+    // ------------------------------------------------------------------------
+    // Pass 2: shuffle each bucket in memory and write it to its output slot
+    // ------------------------------------------------------------------------
+    std::vector<uint64_t> out_offset(buckets, 0);
+    for (uint64_t b = 1; b < buckets; b++) out_offset[b] = out_offset[b - 1] + bucket_bytes[b - 1];
+
+    auto shuffle_start = std::chrono::steady_clock::now();
+    std::atomic<uint64_t> next_bucket{0};
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < opts.threads; t++) {
+        workers.emplace_back([&]() {
+            std::vector<uint8_t> tmp(opts.record_size);
+
+            for (uint64_t b = next_bucket++; b < buckets; b = next_bucket++) {
+                const uint64_t size = bucket_bytes[b];
+                int fd = open(bucket_paths[b].c_str(), O_RDONLY);
+
+                if (size > 0 && fd >= 0) {
+                    // Private mapping: the shuffle happens in memory and never touches the bucket file
+                    void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+                    if (map == MAP_FAILED) {
+                        ok = false;
+                    } else {
+                        uint8_t* data = static_cast<uint8_t*>(map);
+                        const uint64_t n = size / opts.record_size;
+                        std::mt19937_64 rng(opts.seed * 1000003ULL + 0x9E3779B97F4A7C15ULL + b);
+
+                        // Fisher-Yates on records
+                        for (uint64_t i = n - 1; i > 0; i--) {
+                            uint64_t j = std::uniform_int_distribution<uint64_t>(0, i)(rng);
+                            if (i == j) continue;
+
+                            uint8_t* a = data + i * opts.record_size;
+                            uint8_t* c = data + j * opts.record_size;
+                            std::memcpy(tmp.data(), a, opts.record_size);
+                            std::memcpy(a, c, opts.record_size);
+                            std::memcpy(c, tmp.data(), opts.record_size);
+                        }
+
+                        if (!write_full(out_fd, data, size, out_offset[b])) ok = false;
+                        munmap(map, size);
+                    }
+                } else if (fd < 0) {
+                    ok = false;
+                }
+
+                if (fd >= 0) close(fd);
+                unlink(bucket_paths[b].c_str());  // Free disk early, ScratchDir removes the rest
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    close(out_fd);
+
+    if (!ok) {
+        std::cerr << "I/O error during shuffle pass\n";
+        return 1;
+    }
+
+    std::cerr << "Shuffle pass: " << seconds_since(shuffle_start) << "s, wrote " << kept << " records to "
+              << opts.out << "\n";
+    return 0;
+}
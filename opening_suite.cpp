@@ -0,0 +1,284 @@
+// ============================================================================
+// PestoPasta Opening Suite Generator
+// Builds balanced start positions for match testing and self-play data
+//
+// Each candidate is a random line of legal moves played from the start
+// position (or from a book position), scored with a short fixed-depth search
+// and kept only if the score is within the eval band. Positions are
+// deduplicated by Zobrist hash.
+//
+// Compile: g++ -O3 -std=c++17 -pthread -I./chess-library/include -o opening_suite opening_suite.cpp
+// Usage:   ./opening_suite --count 1000 --plies 8 --depth 6 --band 60 --threads 4 --out suite.epd
+// ============================================================================
+
+#define PASTA_NO_MAIN
+#include "pasta_engine.cpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_set>
+
+struct SuiteOptions {
+    int count = 1000;             // Number of positions to write
+    int plies = 8;                // Random plies played from the root
+    int depth = 6;                // Search depth used to score a candidate
+    int band = 60;                // Keep positions with |score| <= band (centipawns)
+    int threads = 1;
+    uint64_t seed = 0;
+    long long max_attempts = 0;   // 0 = 100 attempts per requested position
+    std::string book;             // Optional EPD/FEN file with root positions
+    std::string out = "suite.epd";
+    std::string format = "epd";   // epd or pgn
+};
+
+struct SuitePosition {
+    std::string root_fen;
+    std::vector<Move> line;
+    Board board;
+    int score;  // White's perspective, centipawns
+};
+
+void print_usage() {
+    std::cerr << "Usage: opening_suite [options]\n"
+              << "  --count N        positions to generate (default 1000)\n"
+              << "  --plies N        random plies from the root (default 8)\n"
+              << "  --depth N        search depth for scoring (default 6)\n"
+              << "  --band CP        keep positions with |score| <= CP (default 60)\n"
+              << "  --threads N      search threads (default 1)\n"
+              << "  --seed N         random seed (default 0)\n"
+              << "  --max-attempts N give up after N candidates (default 100 * count)\n"
+              << "  --book FILE      EPD/FEN file with root positions (default startpos)\n"
+              << "  --format F       epd or pgn (default epd)\n"
+              << "  --out FILE       output file (default suite.epd)\n";
+}
+
+bool parse_args(int argc, char* argv[], SuiteOptions& opts) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") return false;
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+
+        std::string value = argv[++i];
+        try {
+            if (arg == "--count") opts.count = std::stoi(value);
+            else if (arg == "--plies") opts.plies = std::stoi(value);
+            else if (arg == "--depth") opts.depth = std::stoi(value);
+            else if (arg == "--band") opts.band = std::stoi(value);
+            else if (arg == "--threads") opts.threads = std::max(1, std::stoi(value));
+            else if (arg == "--seed") opts.seed = std::stoull(value);
+            else if (arg == "--max-attempts") opts.max_attempts = std::stoll(value);
+            else if (arg == "--book") opts.book = value;
+            else if (arg == "--format") opts.format = value;
+            else if (arg == "--out") opts.out = value;
+            else {
+                std::cerr << "Unknown option " << arg << "\n";
+                return false;
+            }
+        } catch (const std::exception&) {
+            // std::stoi and friends throw on non-numeric or out-of-range input
+            std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+            return false;
+        }
+    }
+
+    if (opts.count < 1 || opts.depth < 1) {
+        std::cerr << "--count and --depth must be at least 1\n";
+        return false;
+    }
+    if (opts.plies < 0 || opts.band < 0) {
+        std::cerr << "--plies and --band must not be negative\n";
+        return false;
+    }
+    if (opts.format != "epd" && opts.format != "pgn") {
+        std::cerr << "Unknown format " << opts.format << "\n";
+        return false;
+    }
+    if (opts.max_attempts <= 0) opts.max_attempts = 100LL * opts.count;
+    return true;
+}
+
+std::vector<std::string> load_book(const std::string& path) {
+    std::vector<std::string> roots;
+    std::ifstream file(path);
+    std::string line;
+
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+
+        // EPD lines carry operations after the 4 position fields; keep only those
+        std::istringstream iss(line);
+        std::string field, fen;
+        for (int i = 0; i < 4 && iss >> field; i++) {
+            fen += (i > 0 ? " " : "") + field;
+        }
+
+        Board board;
+        if (board.setFen(fen)) roots.push_back(fen);
+    }
+    return roots;
+}
+
+// Plays random legal moves from the root. Fails if the game ends on the way
+bool play_random_line(SuitePosition& pos, int plies, std::mt19937_64& rng) {
+    Movelist moves;
+
+    for (int ply = 0; ply < plies; ply++) {
+        movegen::legalmoves(moves, pos.board);
+        if (moves.empty()) return false;
+
+        std::uniform_int_distribution<int> pick(0, moves.size() - 1);
+        Move m = moves[pick(rng)];
+
+        pos.board.makeMove(m);
+        pos.line.push_back(m);
+    }
+
+    return pos.board.isGameOver().first == GameResultReason::NONE;
+}
+
+// EPD "ce" is from the side to move's perspective, the search score is White's
+void write_epd(std::ofstream& out, const SuitePosition& pos) {
+    int ce = (pos.board.sideToMove() == Color::WHITE) ? pos.score : -pos.score;
+    out << pos.board.getEpd() << " ce " << ce << ";\n";
+}
+
+void write_pgn(std::ofstream& out, const SuitePosition& pos, int index) {
+    // Seven tag roster first, unknown values as the PGN standard spells them
+    out << "[Event \"Opening suite\"]\n";
+    out << "[Site \"?\"]\n";
+    out << "[Date \"????.??.??\"]\n";
+    out << "[Round \"" << index << "\"]\n";
+    out << "[White \"?\"]\n";
+    out << "[Black \"?\"]\n";
+    out << "[Result \"*\"]\n";
+    if (pos.root_fen != constants::STARTPOS) {
+        out << "[SetUp \"1\"]\n";
+        out << "[FEN \"" << pos.root_fen << "\"]\n";
+    }
+    out << "[Eval \"" << pos.score << "\"]\n\n";  // White's perspective
+
+    Board board(pos.root_fen);
+    std::string movetext;
+
+    for (const auto& m : pos.line) {
+        if (board.sideToMove() == Color::WHITE) {
+            movetext += std::to_string(board.fullMoveNumber()) + ". ";
+        } else if (movetext.empty()) {
+            movetext += std::to_string(board.fullMoveNumber()) + "... ";
+        }
+        movetext += uci::moveToSan(board, m) + " ";
+        board.makeMove(m);
+    }
+
+    out << movetext << "*\n\n";
+}
+
+int main(int argc, char* argv[]) {
+    SuiteOptions opts;
+    if (!parse_args(argc, argv, opts)) {
+        print_usage();
+        return 1;
+    }
+
+    std::vector<std::string> roots = {constants::STARTPOS};
+    if (!opts.book.empty()) {
+        roots = load_book(opts.book);
+        if (roots.empty()) {
+            std::cerr << "No valid positions in " << opts.book << "\n";
+            return 1;
+        }
+    }
+
+    std::mutex mutex;  // Guards seen and suite
+    std::unordered_set<uint64_t> seen;
+    std::vector<SuitePosition> suite;
+    suite.reserve(opts.count);
+
+    std::atomic<long long> attempts{0};
+    std::atomic<long long> duplicates{0};
+    std::atomic<long long> out_of_band{0};
+
+    auto worker = [&](int thread_id) {
+        // Engine is large (TT), one per thread on the heap
+        auto engine = std::make_unique<Engine>();
+        engine->silent = true;
+
+        std::mt19937_64 rng(opts.seed * 1000003ULL + thread_id);
+        std::uniform_int_distribution<size_t> pick_root(0, roots.size() - 1);
+
+        while (attempts++ < opts.max_attempts) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if ((int)suite.size() >= opts.count) return;
+            }
+
+            SuitePosition pos;
+            pos.root_fen = roots[pick_root(rng)];
+            pos.board.setFen(pos.root_fen);
+
+            if (!play_random_line(pos, opts.plies, rng)) continue;
+
+            // Dedupe before searching so no time is spent on known positions
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!seen.insert(pos.board.hash()).second) {
+                    duplicates++;
+                    continue;
+                }
+            }
+
+            engine->clear_tables();
+            engine->board = pos.board;
+            engine->search(opts.depth);
+            pos.score = engine->last_score;
+
+            if (std::abs(pos.score) > opts.band) {
+                out_of_band++;
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if ((int)suite.size() < opts.count) suite.push_back(std::move(pos));
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < opts.threads; t++) {
+        threads.emplace_back(worker, t);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::ofstream out(opts.out);
+    if (!out) {
+        std::cerr << "Could not open " << opts.out << "\n";
+        return 1;
+    }
+
+    for (size_t i = 0; i < suite.size(); i++) {
+        if (opts.format == "epd") write_epd(out, suite[i]);
+        else write_pgn(out, suite[i], i + 1);
+    }
+
+    std::cerr << "Wrote " << suite.size() << "/" << opts.count << " positions to " << opts.out
+              << " (attempts " << std::min<long long>(attempts, opts.max_attempts)
+              << ", duplicates " << duplicates
+              << ", out of band " << out_of_band
+              << ", time " << elapsed << "ms)\n";
+
+    return (int)suite.size() == opts.count ? 0 : 2;
+}
@@ -196,15 +196,25 @@ struct TTEntry {
 // ENGINE CLASS
 // ============================================================================
 
-// Fixed-size Transposition Table (32MB = ~1 million entries)
+// Fixed-size Transposition Table (~24MB = ~1 million entries)
 // More cache-friendly and predictable memory usage than unordered_map
 // Conservative size for Koyeb's 256MB RAM limit (leaves room for stack + OS)
-const size_t TT_SIZE = 1048576;  // 2^20 entries (~32MB with 32-byte entries)
+const size_t TT_SIZE = 1048576;  // 2^20 entries (~24MB with 24-byte entries)
+
+// Small cache-resident table for shallow entries (depth <= SHALLOW_TT_MAX_DEPTH)
+// Meant to keep near-leaf probes in an L2-sized table so they miss DRAM less and
+// don't evict deep entries. Off by default because the data doesn't support it:
+// "bench 8" searches 5,623,350 nodes with it vs 5,379,744 without (+4.5%), and took
+// 4.5-5.1s vs 3.8-4.3s over three interleaved runs each. Depth 1 at 2^16 was the best split measured
+const size_t SHALLOW_TT_SIZE = 65536;  // 2^16 entries (~1.5MB with 24-byte entries)
+const int SHALLOW_TT_MAX_DEPTH = 1;
 
 class Engine {
 public:
     Board board;
     std::vector<TTEntry> tt;
+    std::vector<TTEntry> shallow_tt;
+    bool use_shallow_tt = false;  // UCI option "ShallowTT"
     Move killer_moves[128][2];
     int history_table[64][64];
     // Use same piece values as evaluation for consistency (PeSTO middlegame values)
@@ -214,8 +224,14 @@ public:
     int nodes_searched;
     int quiescence_nodes;
     int tt_hits, tt_misses, tt_cutoffs;
+    int tt_shallow_hits, tt_deep_hits;  // Per-tier split of tt_hits (minimax only)
     int alpha_cutoffs;
 
+    // Score of the last completed search (White's perspective, centipawns)
+    int last_score = 0;
+    // Suppress UCI info output (used by offline tools like opening_suite)
+    bool silent = false;
+
     // Time management
     std::chrono::steady_clock::time_point search_start_time;
     int search_time_limit_ms;
@@ -223,6 +239,7 @@ public:
 
     Engine() {
         tt.resize(TT_SIZE);
+        shallow_tt.resize(SHALLOW_TT_SIZE);
         clear_tables();
         search_time_limit_ms = 0;
         time_up = false;
@@ -247,6 +264,9 @@ public:
         for (size_t i = 0; i < TT_SIZE; i++) {
             tt[i].depth = -1;
         }
+        for (size_t i = 0; i < SHALLOW_TT_SIZE; i++) {
+            shallow_tt[i].depth = -1;
+        }
         for (int i = 0; i < 128; i++) {
             killer_moves[i][0] = killer_moves[i][1] = Move::NO_MOVE;
         }
@@ -257,10 +277,13 @@ public:
         }
     }
 
-    // Probe TT with depth-preferred replacement
-    TTEntry* probe_tt(uint64_t hash) {
-        size_t index = hash % TT_SIZE;
-        TTEntry* entry = &tt[index];
+    // Table sizes are powers of two, so the index is a mask instead of a modulo
+    static TTEntry* tt_slot(std::vector<TTEntry>& table, uint64_t hash) {
+        return &table[hash & (table.size() - 1)];
+    }
+
+    static TTEntry* tt_lookup(std::vector<TTEntry>& table, uint64_t hash) {
+        TTEntry* entry = tt_slot(table, hash);
 
         // Check if entry is valid and matches hash
         if (entry->depth >= 0 && entry->hash == hash) {
@@ -269,10 +292,39 @@ public:
         return nullptr;
     }
 
-    // Store in TT with depth-preferred replacement
+    bool is_shallow(int depth) const {
+        return use_shallow_tt && depth <= SHALLOW_TT_MAX_DEPTH;
+    }
+
+    // Probe both TT tiers, starting with the one this depth is stored in
+    // The other tier is only touched if the first can't answer for this depth
+    // (a shallow node may still find a deep entry, a deep node a move to try first)
+    TTEntry* probe_tt(uint64_t hash, int depth) {
+        TTEntry* first = nullptr;
+        TTEntry* second = nullptr;
+
+        if (is_shallow(depth)) {
+            first = tt_lookup(shallow_tt, hash);
+            if (first == nullptr || first->depth < depth) second = tt_lookup(tt, hash);
+        } else {
+            first = tt_lookup(tt, hash);
+            if (use_shallow_tt && (first == nullptr || first->depth < depth)) second = tt_lookup(shallow_tt, hash);
+        }
+
+        TTEntry* entry = first;
+        if (second != nullptr && (entry == nullptr || second->depth > entry->depth)) {
+            entry = second;
+        }
+        return entry;
+    }
+
+    bool in_shallow_tt(const TTEntry* entry) const {
+        return entry >= shallow_tt.data() && entry < shallow_tt.data() + shallow_tt.size();
+    }
+
+    // Store in TT with depth-preferred replacement (shallow entries go to the small table)
     void store_tt(uint64_t hash, int score, int depth, int flag, Move best_move) {
-        size_t index = hash % TT_SIZE;
-        TTEntry* entry = &tt[index];
+        TTEntry* entry = tt_slot(is_shallow(depth) ? shallow_tt : tt, hash);
 
         // Replace if: empty slot OR same position OR deeper search
         if (entry->depth < 0 || entry->hash == hash || depth >= entry->depth) {
@@ -414,6 +466,62 @@ public:
             }
         }
 
+        // Calculate game phase for delta pruning (same as Python)
+        int phase = calculate_phase(b);
+
+        // Search a batch of tactical moves in the given order with DELTA PRUNING
+        // Returns true on a cutoff (alpha/beta already hold the bound to return)
+        auto search_moves = [&](const auto& batch, bool skip_promotions = false) {
+            for (const auto& m : batch) {
+                if (skip_promotions && m.typeOf() == Move::PROMOTION) continue;
+
+                // DELTA PRUNING: Skip hopeless non-promotion captures
+                // Only when: NOT in check, NOT endgame (phase > 4), NOT promotion
+                const int DELTA_MARGIN = 100;  // 100cp safety margin
+
+                if (!in_check && phase > 4 && m.typeOf() != Move::PROMOTION) {
+                    int victim_value = 0;
+
+                    // Handle en passant specially (captured pawn is not at the "to" square)
+                    if (m.typeOf() == Move::ENPASSANT) {
+                        victim_value = 100;  // Pawn
+                    } else {
+                        auto captured = b.at(m.to());
+                        if (captured != Piece::NONE) {
+                            victim_value = piece_values[pt_index(captured.type())];
+                        }
+                    }
+
+                    if (victim_value > 0) {
+                        // Prune if even capturing + margin can't improve position
+                        if (b.sideToMove() == Color::WHITE) {
+                            if (stand_pat + victim_value + DELTA_MARGIN < alpha) {
+                                continue;  // Skip this hopeless capture
+                            }
+                        } else {
+                            // BLACK: optimistic bound still can't beat beta
+                            if (stand_pat - victim_value + DELTA_MARGIN > beta) {
+                                continue;  // Skip this hopeless capture
+                            }
+                        }
+                    }
+                }
+
+                b.makeMove(m);
+                int score = quiescence(b, alpha, beta, ply_from_root + 1);
+                b.unmakeMove(m);
+
+                if (b.sideToMove() == Color::WHITE) {
+                    if (score >= beta) return true;
+                    if (score > alpha) alpha = score;
+                } else {
+                    if (score <= alpha) return true;
+                    if (score < beta) beta = score;
+                }
+            }
+            return false;
+        };
+
         // Generate moves based on check status
         // CRITICAL: When in check, we MUST search all legal evasions (not just captures)
         // This matches Python behavior and is required for correctness
@@ -426,69 +534,51 @@ public:
             if (moves.size() == 0) {
                 return (b.sideToMove() == Color::WHITE) ? -MATE_VALUE + ply_from_root : MATE_VALUE - ply_from_root;
             }
-        } else {
-            // Not in check: only generate captures (tactical search)
-            movegen::legalmoves<movegen::MoveGenType::CAPTURE>(moves, b);
-            if (moves.size() == 0) return stand_pat;
-        }
 
-        // Calculate game phase for delta pruning (same as Python)
-        int phase = calculate_phase(b);
+            // Sort moves
+            std::vector<Move> sorted_moves(moves.begin(), moves.end());
+            std::sort(sorted_moves.begin(), sorted_moves.end(), [&](const Move& move_a, const Move& move_b) {
+                return score_move(b, move_a, ply_from_root) > score_move(b, move_b, ply_from_root);
+            });
 
-        // Sort moves
-        std::vector<Move> sorted_moves;
-        for (const auto& m : moves) {
-            sorted_moves.push_back(m);
-        }
-        std::sort(sorted_moves.begin(), sorted_moves.end(), [&](const Move& move_a, const Move& move_b) {
-            return score_move(b, move_a, ply_from_root) > score_move(b, move_b, ply_from_root);
-        });
+            if (search_moves(sorted_moves)) {
+                return (b.sideToMove() == Color::WHITE) ? beta : alpha;
+            }
+        } else {
+            // Not in check: only generate captures (tactical search)
+            // Capture-promotions go first (as in score_move), then the remaining captures are
+            // generated victim by victim (MVV) so a cutoff skips generating the rest.
+            // Within a victim the generator yields K, P, N, B, R, Q attackers, the same order
+            // score_move gives them (victim * 10 - attacker, with the king valued 0).
+            bool has_captures = false;
+            const Color them = ~b.sideToMove();
+
+            if (b.pieces(PieceType::PAWN, b.sideToMove()) & Rank::rank(Rank::RANK_7, b.sideToMove()).bb()) {
+                Bitboard promo_targets = b.us(them) & Rank::rank(Rank::RANK_8, b.sideToMove()).bb();
+                movegen::legalmoves<movegen::MoveGenType::CAPTURE, PieceGenType::PAWN>(moves, b, promo_targets);
+                has_captures |= !moves.empty();
+
+                if (search_moves(moves)) {
+                    return (b.sideToMove() == Color::WHITE) ? beta : alpha;
+                }
+            }
 
-        // Search tactical moves with DELTA PRUNING
-        for (const auto& m : sorted_moves) {
-            // DELTA PRUNING: Skip hopeless non-promotion captures
-            // Only when: NOT in check, NOT endgame (phase > 4), NOT promotion
-            const int DELTA_MARGIN = 100;  // 100cp safety margin
+            const PieceType victims[] = {PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT,
+                                         PieceType::PAWN};
 
-            if (!in_check && phase > 4 && m.typeOf() != Move::PROMOTION) {
-                int victim_value = 0;
+            for (const auto victim : victims) {
+                Bitboard targets = b.pieces(victim, them);
+                if (!targets) continue;
 
-                // Handle en passant specially (captured pawn is not at the "to" square)
-                if (m.typeOf() == Move::ENPASSANT) {
-                    victim_value = 100;  // Pawn
-                } else {
-                    auto captured = b.at(m.to());
-                    if (captured != Piece::NONE) {
-                        victim_value = piece_values[pt_index(captured.type())];
-                    }
-                }
+                movegen::legalmoves<movegen::MoveGenType::CAPTURE>(moves, b, targets);
+                has_captures |= !moves.empty();
 
-                if (victim_value > 0) {
-                    // Prune if even capturing + margin can't improve position
-                    if (b.sideToMove() == Color::WHITE) {
-                        if (stand_pat + victim_value + DELTA_MARGIN < alpha) {
-                            continue;  // Skip this hopeless capture
-                        }
-                    } else {
-                        // BLACK: optimistic bound still can't beat beta
-                        if (stand_pat - victim_value + DELTA_MARGIN > beta) {
-                            continue;  // Skip this hopeless capture
-                        }
-                    }
+                if (search_moves(moves, true)) {
+                    return (b.sideToMove() == Color::WHITE) ? beta : alpha;
                 }
             }
 
-            b.makeMove(m);
-            int score = quiescence(b, alpha, beta, ply_from_root + 1);
-            b.unmakeMove(m);
-
-            if (b.sideToMove() == Color::WHITE) {
-                if (score >= beta) return beta;
-                if (score > alpha) alpha = score;
-            } else {
-                if (score <= alpha) return alpha;
-                if (score < beta) beta = score;
-            }
+            if (!has_captures) return stand_pat;
         }
 
         return (b.sideToMove() == Color::WHITE) ? alpha : beta;
@@ -521,9 +611,12 @@ public:
         // Transposition table lookup
         // Note: We use TT even at root (ply_from_root == 0) to reuse previous search
         uint64_t hash = b.hash();
-        TTEntry* entry = probe_tt(hash);
+        TTEntry* entry = probe_tt(hash, depth);
+        Move tt_move = (entry != nullptr) ? entry->best_move : Move::NO_MOVE;
         if (entry != nullptr && entry->depth >= depth) {
             tt_hits++;
+            if (in_shallow_tt(entry)) tt_shallow_hits++;
+            else tt_deep_hits++;
             int tt_score = entry->score;
 
             // De-normalize mate scores from TT (restore ply-relative mate distance)
@@ -599,13 +692,8 @@ public:
             return evaluate(b, ply_from_root);
         }
 
-        // Move ordering
+        // Move ordering (tt_move was read at the TT lookup above)
         std::vector<Move> moves;
-        Move tt_move = Move::NO_MOVE;
-        TTEntry* tt_entry = probe_tt(hash);
-        if (tt_entry != nullptr) {
-            tt_move = tt_entry->best_move;
-        }
 
         for (const auto& m : movelist) {
             if (m == tt_move) {
@@ -725,6 +813,7 @@ public:
         nodes_searched = 0;
         quiescence_nodes = 0;
         tt_hits = tt_misses = tt_cutoffs = alpha_cutoffs = 0;
+        tt_shallow_hits = tt_deep_hits = 0;
 
         // Initialize time management
         search_start_time = std::chrono::steady_clock::now();
@@ -771,7 +860,7 @@ public:
 
             // Only use this result if search completed (time didn't run out)
             if (!time_up) {
-                TTEntry* entry = probe_tt(board.hash());
+                TTEntry* entry = probe_tt(board.hash(), depth);
                 if (entry != nullptr) {
                     last_completed_move = entry->best_move;  // Save completed depth result
                     best_move = last_completed_move;
@@ -792,7 +881,7 @@ public:
             float qs_pct = (nodes_searched > 0) ? (quiescence_nodes * 100.0 / nodes_searched) : 0.0;
 
             // Only print info for completed depths
-            if (!time_up) {
+            if (!time_up && !silent) {
                 std::cout << "info depth " << depth
                           << " score cp " << best_score
                           << " nodes " << nodes_searched
@@ -801,6 +890,8 @@ public:
                           << " pv " << uci::moveToUci(best_move)
                           << " tthits " << tt_hits
                           << " ttrate " << (int)tt_hit_rate
+                          << " ttshallowhits " << tt_shallow_hits
+                          << " ttdeephits " << tt_deep_hits
                           << " ttcutoffs " << tt_cutoffs
                           << " abcutoffs " << alpha_cutoffs
                           << " qsnodes " << quiescence_nodes
@@ -809,6 +900,8 @@ public:
             }
         }
 
+        last_score = best_score;
+
         // Safety: If no move was found (extremely rare), pick first legal move
         if (best_move == Move::NO_MOVE) {
             Movelist moves;
@@ -826,6 +919,48 @@ public:
 // UCI PROTOCOL
 // ============================================================================
 
+// Fixed-depth search over a small position set, used to tune the engine for nps and time-to-depth
+// Usage: bench [depth]
+void bench(Engine& engine, int depth) {
+    const char* BENCH_FENS[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 1",
+    };
+
+    long long total_nodes = 0;
+    long long total_shallow_hits = 0, total_deep_hits = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (const char* fen : BENCH_FENS) {
+        engine.clear_tables();
+        engine.board.setFen(fen);
+        engine.search(depth);
+
+        total_nodes += engine.nodes_searched;
+        total_shallow_hits += engine.tt_shallow_hits;
+        total_deep_hits += engine.tt_deep_hits;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "bench depth " << depth
+              << " nodes " << total_nodes
+              << " time " << elapsed
+              << " nps " << (elapsed > 0 ? (total_nodes * 1000 / elapsed) : 0)
+              << " ttshallowhits " << total_shallow_hits
+              << " ttdeephits " << total_deep_hits
+              << std::endl;
+
+    engine.clear_tables();
+    engine.board.setFen(constants::STARTPOS);
+}
+
 void uci_loop() {
     Engine engine;
     std::string line, token;
@@ -837,11 +972,27 @@ void uci_loop() {
         if (token == "uci") {
             std::cout << "id name PestoPasta C++ v2.0\n";
             std::cout << "id author PestoPasta\n";
+            std::cout << "option name ShallowTT type check default false\n";
             std::cout << "uciok\n";
         }
         else if (token == "isready") {
             std::cout << "readyok\n";
         }
+        else if (token == "setoption") {
+            // setoption name ShallowTT value <true|false>
+            std::string name_token, name, value_token, value;
+            iss >> name_token >> name >> value_token >> value;
+
+            if (name == "ShallowTT") {
+                engine.use_shallow_tt = (value == "true");
+                engine.clear_tables();
+            }
+        }
+        else if (token == "bench") {
+            int depth = 6;
+            iss >> depth;
+            bench(engine, depth);
+        }
         else if (token == "ucinewgame") {
             engine.clear_tables();
             engine.board.setFen(constants::STARTPOS);
@@ -938,7 +1089,10 @@ void uci_loop() {
     }
 }
 
+// Tools that reuse the Engine class include this file with PASTA_NO_MAIN defined
+#ifndef PASTA_NO_MAIN
 int main() {
     uci_loop();
     return 0;
 }
+#endif